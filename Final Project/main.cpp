@@ -1,19 +1,25 @@
 #include <iostream>
 #include <iomanip>
 #include <cstdlib>
+#include <cstdio>
+#include <cerrno>
+#include <climits>
 #include <string>
 #include <ctime>
+#include <random>
+#include <fstream>
+#include <chrono>
 
 using std::cout;
 using std::cin;
 using std::string;
-using std::endl;
 using std::setw;
 using std::setfill;
-using std::srand;
-using std::rand;
 using std::time;
 using std::min;
+using std::ofstream;
+using std::ifstream;
+using std::ios;
 
 // ------------------------------------------------
 // PLAYER COMBAT ENUM
@@ -46,6 +52,269 @@ enum Item {
 	STRENGTH_ELIXIR
 };
 
+// ------------------------------------------------
+// DECISION TYPE ENUM
+// ------------------------------------------------
+// I created this enum to label each entry in the decision trace so we know if the value was a room choice, a combat action, an item pick or a dice roll.
+enum DecisionType {
+	ROOM_CHOICE,
+	COMBAT_ACTION,
+	ITEM_CHOICE,
+	DICE_ROLL
+};
+
+// ------------------------------------------------
+// DECISION TRACE STRUCTURE
+// ------------------------------------------------
+// Start the game with --record-decisions to record every choice the player makes and every d20 roll. The trace is added to the end of decision_trace.txt when the game ends.
+// Max number of decisions we can record in one game. Once the trace is full we just count the extra decisions instead of recording them so it never uses more memory than this.
+const int MAX_DECISIONS = 2000;
+
+struct DecisionTrace {
+	// Instead of one array of records, each kind of value gets its own array (a column).
+	// Every value fits in one byte so the columns stay small, and since the columns are written out separately anyone looking at just the rolls only has to read the rolls.
+	unsigned char room[MAX_DECISIONS] = {}; // Which room the player was in when the decision happened
+	unsigned char type[MAX_DECISIONS] = {}; // What kind of decision it was (DecisionType)
+	unsigned char value[MAX_DECISIONS] = {}; // The choice the player entered or the number that was rolled
+	int size = 0; // How many decisions have been recorded
+	int dropped = 0; // How many decisions happened after the trace was full and couldn't be recorded
+	bool enabled = false; // main turns this on when the game is started with --record-decisions
+	int currentRoom = 0; // main updates this every time through the game loop so the other functions don't need to know what room the player is in
+
+	// Method to record one decision in the trace
+	void record(DecisionType decisionType, int decisionValue) {
+		// Don't record anything if recording is turned off
+		if (!enabled) {
+			return;
+		}
+		// If the trace is already full then we just count the decision so the file can show that some are missing
+		if (size >= MAX_DECISIONS) {
+			dropped++;
+			return;
+		}
+		room[size] = static_cast<unsigned char>(currentRoom);
+		type[size] = static_cast<unsigned char>(decisionType);
+		// The player can type in any number so anything that doesn't fit in a byte is saved as 255 which we treat as an invalid choice
+		if (decisionValue < 0 || decisionValue > 254) {
+			decisionValue = 255;
+		}
+		value[size] = static_cast<unsigned char>(decisionValue);
+		size++;
+	}
+
+	// Helper method to write one column to the file
+	// The room and type columns have long runs of the same value (the player makes a lot of choices in the same room) so we write each run as value*count instead of repeating the value.
+	void writeColumn(ofstream& file, const char* label, const unsigned char column[]) const {
+		file << label << ":";
+		int i = 0;
+		while (i < size) {
+			// Count how many times in a row this value shows up
+			int runLength = 1;
+			while (i + runLength < size && column[i + runLength] == column[i]) {
+				runLength++;
+			}
+			file << " " << static_cast<int>(column[i]);
+			if (runLength > 1) {
+				file << "*" << runLength;
+			}
+			i += runLength;
+		}
+		file << "\n";
+	}
+
+	// Method to add this game's trace to the end of the trace file
+	void writeToFile(const char* fileName) const {
+		if (!enabled || size == 0) {
+			return;
+		}
+		// ios::app adds to the end of the file so the traces from every game are kept
+		ofstream file(fileName, ios::app);
+		if (!file) {
+			cout << "Could not open " << fileName << " to save the decision trace.\n";
+			return;
+		}
+		file << "game: " << size << " dropped: " << dropped << "\n";
+		writeColumn(file, "room", room);
+		writeColumn(file, "type", type);
+		writeColumn(file, "value", value);
+	}
+};
+
+// ------------------------------------------------
+// DICE
+// ------------------------------------------------
+// The random number engine used for every d20 roll.
+// I switched from rand() % 20 + 1 to this because rand() % 20 doesn't give every number the same chance. On Windows rand() only goes up to 32767 so the numbers 1-8 come up slightly more often than 9-20.
+// With the engine and uniform_int_distribution every side of the die has exactly a 1 in 20 chance, so the odds of things like the altar's curse (7 in 20) or the enraged guardian (5 in 20) are exactly what the game says they are.
+std::mt19937 diceEngine;
+
+// The decision trace is global so that the player's methods, the combat function and rollD20 can all record to it
+DecisionTrace decisionTrace;
+
+// ------------------------------------------------
+// TIMING TRACE STRUCTURE
+// ------------------------------------------------
+// Start the game with --trace-timings to time each part of the game (waiting for input, combat turns, taking damage and using items).
+// The timings are saved to timing_trace.json when the game ends. That file can be opened in chrome://tracing or ui.perfetto.dev to see a timeline.
+// When timing is turned off every timing check returns right away so it costs almost nothing.
+// Max number of timings we keep. When the array is full the oldest timings get overwritten so memory never grows.
+const int MAX_TIMINGS = 4096;
+// If a combat turn takes longer than this (not counting time spent waiting for the player to type) the trace is saved right away so we can see what was slow
+const long long SLOW_TURN_NS = 50000000; // 50 milliseconds
+
+// One timed section of the game
+struct TimingEvent {
+	const char* name = ""; // What was being timed
+	long long startNs = 0; // When it started in nanoseconds since the game started
+	long long durationNs = 0; // How long it took in nanoseconds
+};
+
+struct TimingTrace {
+	TimingEvent events[MAX_TIMINGS];
+	int next = 0; // The slot the next timing will be written to
+	int count = 0; // How many slots have been filled (never more than MAX_TIMINGS)
+	long long inputNs = 0; // Total time spent waiting for input. Combat turns use this to leave out the time the player spends typing.
+	bool enabled = false; // main turns this on when the game is started with --trace-timings
+	std::chrono::steady_clock::time_point gameStart = std::chrono::steady_clock::now();
+
+	// Method that returns the number of nanoseconds since the game started
+	long long now() const {
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - gameStart).count();
+	}
+
+	// Method to save a timing in the next slot. Once we reach the end of the array we wrap around to slot 0 and start overwriting the oldest timings.
+	void record(const char* name, long long startNs, long long durationNs) {
+		events[next].name = name;
+		events[next].startNs = startNs;
+		events[next].durationNs = durationNs;
+		next = (next + 1) % MAX_TIMINGS;
+		if (count < MAX_TIMINGS) {
+			count++;
+		}
+	}
+
+	// Method to write the timings to a file in the Chrome trace format
+	void writeToFile(const char* fileName) const {
+		if (!enabled) {
+			return;
+		}
+		ofstream file(fileName);
+		if (!file) {
+			cout << "Could not open " << fileName << " to save the timing trace.\n";
+			return;
+		}
+		file << "{\"traceEvents\":[\n";
+		// If the array has wrapped around then the oldest timing is in the slot we would write to next, otherwise it's in slot 0
+		int first = (count < MAX_TIMINGS) ? 0 : next;
+		for (int i = 0; i < count; i++) {
+			const TimingEvent& event = events[(first + i) % MAX_TIMINGS];
+			// Chrome wants the times in microseconds so we divide the nanoseconds by 1000
+			file << "{\"name\":\"" << event.name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":1"
+				<< ",\"ts\":" << event.startNs / 1000 << "." << setw(3) << setfill('0') << event.startNs % 1000
+				<< ",\"dur\":" << event.durationNs / 1000 << "." << setw(3) << event.durationNs % 1000 << setfill(' ')
+				<< "}" << (i + 1 < count ? ",\n" : "\n");
+		}
+		file << "]}\n";
+	}
+};
+
+// The timing trace is global so that every part of the game can add timings to it
+TimingTrace timingTrace;
+
+// ------------------------------------------------
+// TIMED SECTION STRUCTURE
+// ------------------------------------------------
+// Creating one of these starts a timer and when it goes out of scope (at the closing brace of the block it was made in) the time is saved to the timing trace.
+// This way we don't have to remember to stop the timer before every return, break or continue.
+struct TimedSection {
+	const char* name;
+	long long startNs = 0;
+	long long inputNsAtStart = 0;
+	bool isInput; // Input sections add their time to the trace's total input time
+	bool isCombatTurn; // Combat turns save the trace right away if they are too slow
+	bool active; // Whether timing was turned on when this section started
+
+	TimedSection(const char* name, bool isInput = false, bool isCombatTurn = false) : name(name), isInput(isInput), isCombatTurn(isCombatTurn), active(timingTrace.enabled) {
+		if (active) {
+			startNs = timingTrace.now();
+			inputNsAtStart = timingTrace.inputNs;
+		}
+	}
+
+	~TimedSection() {
+		if (!active) {
+			return;
+		}
+		long long durationNs = timingTrace.now() - startNs;
+		timingTrace.record(name, startNs, durationNs);
+		if (isInput) {
+			timingTrace.inputNs += durationNs;
+		}
+		// Leave out the time spent waiting for the player and check if the turn itself was slow
+		if (isCombatTurn && durationNs - (timingTrace.inputNs - inputNsAtStart) > SLOW_TURN_NS) {
+			timingTrace.writeToFile("timing_trace.json");
+		}
+	}
+};
+
+// ------------------------------------------------
+// READ INPUT FUNCTION
+// ------------------------------------------------
+// Every time the game reads what the player typed it goes through this function so each read is timed the same way.
+// cin is tied to cout, so right before reading, cin flushes everything the game has printed. We flush it ourselves first in its own timed section so slow console output shows up as "flush" in the timing trace and counts towards a slow combat turn, instead of hiding inside the time spent waiting for the player.
+// It is a template so it works for both the numbers and the strings the game reads.
+template <typename T>
+void readInput(T& value) {
+	{
+		TimedSection flushTimer("flush");
+		cout.flush();
+	}
+	TimedSection inputTimer("input", true);
+	cin >> value;
+}
+
+// ------------------------------------------------
+// GAME CONTENT STRUCTURE
+// ------------------------------------------------
+// This structure holds all of the numbers used to balance the game. The monster stats, how strong the items are and the rolls needed in each room.
+// The values here are the defaults. If there is a content.txt file next to the game then the values in it replace these, so the game can be rebalanced without rebuilding it.
+struct GameContent {
+	// Monster roster
+	int phantomHp = 50;
+	int phantomAtk = 10;
+	int ghoulHp = 70;
+	int ghoulAtk = 15;
+	int guardianHp = 85;
+	int guardianAtk = 20;
+	int necromancerHp = 100;
+	int necromancerAtk = 25;
+
+	// Item table
+	int potionHeal = 50; // How much HP a health potion restores
+	int elixirBoost = 20; // How much attack power a strength elixir adds
+
+	// Room 2 flee rolls
+	int fleeCritRoll = 15; // The ghoul lands a critical hit on this roll or higher
+	int fleeSlipRoll = 5; // The player slips away with the elixir on this roll or lower
+
+	// Room 3 altar rolls
+	int boonRoll = 14; // The altar grants its boon on this roll or higher
+	int boonMaxHpCost = 5;
+	int boonAtkBonus = 10;
+	int curseRoll = 7; // The altar curses the player on this roll or lower
+	int curseMaxHpLoss = 10;
+	int curseAtkLoss = 5;
+
+	// Room 4 deception rolls
+	int deceivePassRoll = 12; // The guardian is deceived on this roll or higher
+	int deceiveEnrageRoll = 5; // The guardian becomes enraged on this roll or lower
+	int enragedAtkBonus = 5;
+	int enragedHpBonus = 10;
+};
+
+// The content the game is currently using. It is global so that the player's methods can use the item values too.
+GameContent gameContent;
+
 // ------------------------------------------------
 // PLAYER STRUCTURE
 // ------------------------------------------------
@@ -66,12 +335,13 @@ struct Player {
 	// This method is called in various places to update the character on how healthy they are
 	// It can also be called by the player at any time in the rooms to check their current stats
 	void displayStats() const {
-		cout << "You currently have " << hp << " HP and " <<atkPwr << " attack power." << endl;
+		cout << "You currently have " << hp << " HP and " <<atkPwr << " attack power.\n";
 	}
 
 	// Helper method to convert an item enum value to a string for display purposes
 	// Since the items are represented as enums, I created this helper method to convert them to strings so that they are more readable when displayed to the player in the inventory and when they use an item.
-	string itemToString(const Item& item) const {
+	// It returns a const char* instead of a string because the item names never change. This way we just point at the text instead of building a new string every time the inventory is displayed.
+	const char* itemToString(const Item& item) const {
 		switch (item) {
 		case HEALTH_POTION:
 			return "Health Potion";
@@ -89,11 +359,11 @@ struct Player {
 		if (inventorySize < 3) {
 			inventory[inventorySize] = item;
 			inventorySize++;
-			cout << "You have added " << itemToString(item) << " to your inventory." << endl;
+			cout << "You have added " << itemToString(item) << " to your inventory.\n";
 		}
 		else {
 			// Otherwise, we let the player know their inventory is full and they can't add the item
-			cout << "Your inventory is full! You cannot add " << itemToString(item) << "." << endl;
+			cout << "Your inventory is full! You cannot add " << itemToString(item) << ".\n";
 		}
 
 	}
@@ -103,27 +373,28 @@ struct Player {
 
 		// Check to see if there are any items in the inventory before displaying
 		if (inventorySize == 0) {
-			cout << "Your inventory is empty!" << endl;
+			cout << "Your inventory is empty!\n";
 		}
 
 		// Otherwise we display the player's inventory 
-		cout << "Your Inventory:" << endl;
+		cout << "Your Inventory:\n";
 
 		// Loop through the Player's inventory and display it
 		for (int i = 0; i < inventorySize; i++) {
-			cout << (i + 1) << ": " << itemToString(inventory[i]) << endl;
+			cout << (i + 1) << ": " << itemToString(inventory[i]) << "\n";
 		}
 
 		// Display final option for closing the inventory 
-		cout << "0: Close Inventory" << endl;
+		cout << "0: Close Inventory\n";
 	}
 
 	// Method to use items from the player's inventory 
 	void useItem() {
+		TimedSection timer("useItem");
 
 		// Check to see if there are any items in the inventory before displaying
 		if (inventorySize == 0) {
-			cout << "Your inventory is empty!" << endl;
+			cout << "Your inventory is empty!\n";
 			return; // Exit the method if there are no items to use
 		}
 
@@ -131,19 +402,20 @@ struct Player {
 		displayInventory();
 
 		// Get the player's choice
-		cout << "Select the number of the item you want to use or 0 to close your inventory: " << endl;
+		cout << "Select the number of the item you want to use or 0 to close your inventory: \n";
 		int choice; 
-		cin >> choice;
+		readInput(choice);
+		decisionTrace.record(ITEM_CHOICE, choice);
 
 		// If the user picks 0 then they close their inventory
 		if (choice == 0) {
-			cout << "You close your inventory." << endl;
+			cout << "You close your inventory.\n";
 			return;
 		}
 
 		// Then we check to see if the player's choice is valid and if so we use the item
 		if (choice < 1 || choice > inventorySize) {
-			cout << "Invalid choice! Please select a valid item number." << endl;
+			cout << "Invalid choice! Please select a valid item number.\n";
 			return;
 		}
 
@@ -152,24 +424,24 @@ struct Player {
 
 		switch (selectedItem) {
 		case HEALTH_POTION:
-			hp += 50; // Heal the player by 50 HP
+			hp += gameContent.potionHeal; // Heal the player by the potion's heal amount (50 HP by default)
 			// I don't want the player's HP to exceed 100 so I check the player's current HP after using the hp pot and if it exceeds the current max HP then I set it to the max HP
 			if (hp > maxHp) {
 				hp = maxHp;
 			}
-			cout << "You use a health potion and restore 50 HP!" << endl;
+			cout << "You use a health potion and restore " << gameContent.potionHeal << " HP!\n";
 			// Display the player's new stat total
 			displayStats();
 			break;
 		case STRENGTH_ELIXIR:
-			// If the selected item is a strength elixr then we add 20 points to their atk
-			atkPwr += 20;
-			cout << "You use a strength elixir and increase your attack power by 20!" << endl;
+			// If the selected item is a strength elixr then we add the elixir's boost to their atk (20 points by default)
+			atkPwr += gameContent.elixirBoost;
+			cout << "You use a strength elixir and increase your attack power by " << gameContent.elixirBoost << "!\n";
 			// Display the player's new stat total
 			displayStats();
 			break;
 		default:
-			cout << "Invalid item! Please select a valid item number." << endl;
+			cout << "Invalid item! Please select a valid item number.\n";
 			return;
 		};
 		// Finally we remove the used item from the player's inventory 
@@ -192,68 +464,187 @@ struct Player {
 // MONSTER STRUCTURE
 // ------------------------------------------------
 struct Monster {
-	string name; // Monster's name for display purposes in combat and dialogue
+	// Monster's name for display purposes in combat and dialogue
+	// Monster names are always written directly in the code so I store them as a const char* that points at that text. This way creating the monsters doesn't need to allocate any memory for copies of their names.
+	const char* name;
 	int hp; // Monster's HP. This is used to track how much health the monster has left in combat and to determine when the monster is defeated.
 	int atkPwr; // Monster's attack power. This is used to calculate the damage the monster deals to the player in combat.
-	Monster(const string& name, int hp, int atkPwr) : name(name), hp(hp), atkPwr(atkPwr) {}
+	Monster(const char* name, int hp, int atkPwr) : name(name), hp(hp), atkPwr(atkPwr) {}
 };
 
+// ------------------------------------------------
+// SNAPSHOT STRUCTURE
+// ------------------------------------------------
+// A copy of everything that can change during a combat turn: the player, the monster they are fighting and the dice.
+// Because the dice are copied too, restoring a snapshot and picking a different action rolls the exact same dice as before. So you can see what really would have happened if you had blocked instead of attacked.
+// A snapshot isn't free. The dice engine is about 2.5 KB and copying the player's name can allocate memory if the name is too long to fit inside the string itself.
+// So snapshots are only taken when rewinding is turned on, and the same snapshot is written over every turn so the name's memory gets reused instead of allocated again.
+struct GameSnapshot {
+	// The player and monster start out empty until the first snapshot is taken
+	Player player = Player("", 0, 0);
+	Monster monster = Monster("", 0, 0);
+	std::mt19937 dice;
+};
+
+// Start the game with --rewind to be able to rewind the last combat turn when you die. It is off by default so normal games play by the normal rules.
+bool rewindEnabled = false;
+
 // -----------------------------------------------
 // FUNCTION PROTOTYPES
 // -----------------------------------------------
 CombatResult combat(Player& player, Monster& monster);
+bool handleCombatResult(CombatResult combatResult, const Monster& monster, bool& gameOver);
+void takeSnapshot(GameSnapshot& snapshot, const Player& player, const Monster& monster);
+void restoreSnapshot(const GameSnapshot& snapshot, Player& player, Monster& monster);
 int rollD20();
 void applyDamage(Player& player, int damage);
+bool loadContent(const char* fileName, GameContent& content);
+bool isValidContent(const GameContent& content);
+bool parseSeed(const char* text, unsigned int& seed);
+void printUsage(const char* programName);
+void saveGame(const char* fileName, const Player& player, int currentRoom);
+bool loadGame(const char* fileName, Player& player, int& currentRoom);
+void deleteSave(const char* fileName);
+
+
+
+
+// main takes the command line arguments so that a dice seed and options can be passed in when the game is started, for example: "Final Project.exe 12345 --record-decisions"
+int main(int argc, char* argv[]) {
+	// I used to end every line with endl but endl also flushes the output which means every single line gets written to the console on its own.
+	// Now lines end with "\n" so the output is saved up and written in bigger chunks. cin is tied to cout so everything is still flushed before the game waits for the player to type.
+	// Turning off sync_with_stdio lets cout use its own buffer instead of going through the C stdio functions for every write.
+	std::ios::sync_with_stdio(false);
+
+	// Seed the dice engine with the current time to ensure different outcomes each time the game is played
+	// time returns a time_t but the engine's seed is an unsigned int so we use a static cast to convert it and avoid a warning
+	unsigned int diceSeed = static_cast<unsigned int>(time(nullptr));
+	// If a seed was passed in on the command line then we use that instead. The same seed always gives the same sequence of d20 rolls.
+	// This way two different strategies can be played against the exact same dice to see which one really does better.
+	// We check each command line argument. Anything that isn't an option is the dice seed.
+	const char* seedArg = nullptr;
+	for (int i = 1; i < argc; i++) {
+		string arg = argv[i];
+		if (arg == "--record-decisions") {
+			decisionTrace.enabled = true;
+		}
+		else if (arg == "--rewind") {
+			rewindEnabled = true;
+		}
+		else if (arg == "--trace-timings") {
+			timingTrace.enabled = true;
+		}
+		// Anything else that starts with -- is an option we don't know, and only one seed can be given
+		else if (arg.rfind("--", 0) == 0 || seedArg != nullptr) {
+			printUsage(argv[0]);
+			return 1;
+		}
+		else {
+			seedArg = argv[i];
+		}
+	}
+	// If the seed isn't a valid number then we stop instead of quietly playing with different dice than the player asked for
+	if (seedArg != nullptr && !parseSeed(seedArg, diceSeed)) {
+		cout << "Invalid dice seed '" << seedArg << "'. The seed must be a whole number from 0 to " << UINT_MAX << ".\n";
+		printUsage(argv[0]);
+		return 1;
+	}
 
+	cout << "Welcome to this simple DnD like game!\n";
+	// Create a player with the default stats. Their name gets filled in below once we know if this is a new game or a saved one.
+	Player player("", 150, 20);
+	// First we start by setting the current room the player is in to 1
+	int currentRoom = 1;
 
+	// If the last game was closed or crashed before it finished then there will be a save file, so we give the player the option to pick up where they left off
+	bool resumedGame = false;
+	if (loadGame("savegame.txt", player, currentRoom)) {
+		cout << "A saved game was found for " << player.name << " in room " << currentRoom << ". Do you want to continue it? (yes/no) ";
+		string resumeChoice;
+		readInput(resumeChoice);
+		if (resumeChoice == "yes") {
+			resumedGame = true;
+			cout << "Welcome back, " << player.name << "! You continue your quest where you left off.\n";
+			player.displayStats();
+		}
+		else {
+			// If they don't want to continue then we start over with a fresh player in room 1
+			player = Player("", 150, 20);
+			currentRoom = 1;
+			// We also delete the save so it doesn't get offered again next time, even if this new game ends before the first save
+			deleteSave("savegame.txt");
+		}
+	}
 
-
-int main() {
-	// Seed the random number generator with the current time to ensure different outcomes each time the game is played
-	// I was getting a warning with srand(time(nullptr)) and on stack overflow I read that srand expects an unsigned int and time returns a time_t so I added a static cast to convert the time_t to an unsigned int and that got rid of the warning
-	srand(static_cast<unsigned int>(time(nullptr)));
-
-	cout << "Welcome to this simple DnD like game!" << endl;
-	cout << "Please enter the name of your character: ";
-	// We get the player's input for their name
-	string playerName;
-	cin >> playerName;
-
-	// Create a player with the name entered by the user and default stats
-	Player player(playerName, 150, 20);
-	// Monsters for the player to fight
-	Monster phantom("Phantom", 50, 10);
-	Monster ghoul("Ghoul", 70, 15);
-	Monster guardian("Guardian", 85, 20);
-	Monster necromancer("Necromancer", 100, 25);
-
-	// intro dialogue displaying the player's name and stats
-	cout << "Welcome, " << player.name << "! You are a brave adventurer embarking on a quest." << endl;
-	player.displayStats();
-
-	// Dialogue for entering the crypt
-	cout << "You find yourself standing in front of a dark and ominous crypt. Do you wish to enter? (yes/no) ";
-	string choice;
-	cin >> choice;
-
-	// If the player chooses to enter the crypt then we start the game
-	if (choice == "yes") {
-		cout << "You step into the crypt and the door slams shut behind you. You are now trapped inside!" << endl;
+	if (resumedGame) {
+		// loadGame already put the dice back the way they were in the saved game, so the seed isn't used
+		cout << "The dice continue from your saved game.\n";
 	}
 	else {
-		cout << "You decide to stay outside and miss out on the adventure that awaits inside the crypt." << endl;
-		return 0; // End the game if the player chooses not to enter the crypt
+		diceEngine.seed(diceSeed);
+		// We show the seed so the player can replay this game with the same dice
+		cout << "Dice seed: " << diceSeed << "\n";
+	}
+
+	if (!resumedGame) {
+		cout << "Please enter the name of your character: ";
+		// We get the player's input for their name
+		string playerName;
+		readInput(playerName);
+		player.name = playerName;
+
+		// intro dialogue displaying the player's name and stats
+		cout << "Welcome, " << player.name << "! You are a brave adventurer embarking on a quest.\n";
+		player.displayStats();
+
+		// Dialogue for entering the crypt
+		cout << "You find yourself standing in front of a dark and ominous crypt. Do you wish to enter? (yes/no) ";
+		string choice;
+		readInput(choice);
+
+		// If the player chooses to enter the crypt then we start the game
+		if (choice == "yes") {
+			cout << "You step into the crypt and the door slams shut behind you. You are now trapped inside!\n";
+		}
+		else {
+			cout << "You decide to stay outside and miss out on the adventure that awaits inside the crypt.\n";
+			return 0; // End the game if the player chooses not to enter the crypt
+		}
 	}
 
+	// Load the game content before creating the monsters so they use the current balance values
+	loadContent("content.txt", gameContent);
+	// Monsters for the player to fight
+	Monster phantom("Phantom", gameContent.phantomHp, gameContent.phantomAtk);
+	Monster ghoul("Ghoul", gameContent.ghoulHp, gameContent.ghoulAtk);
+	Monster guardian("Guardian", gameContent.guardianHp, gameContent.guardianAtk);
+	Monster necromancer("Necromancer", gameContent.necromancerHp, gameContent.necromancerAtk);
+
 	// Dungeon gameplay loop
-	// First we start by setting the current room the player is in to 1
-	int currentRoom = 1;
 	// We also create a boolean variable to track whether the game is over or not.
 	bool gameOver = false;
+	// This tracks which room the current game content was loaded for. The content was just loaded for the room we are starting in.
+	int contentRoom = currentRoom;
 
 	// We start the game loop and it continues as long as the game is not over
 	// Once gameOver is set to true then the loop will end 
 	while (!gameOver) {
+		// Let the decision trace know which room we are in
+		decisionTrace.currentRoom = currentRoom;
+
+		// Every time the player moves to a new room we load content.txt again so balance changes show up without restarting the game.
+		// We only do this when the room changes so nothing changes in the middle of a room or a fight.
+		if (currentRoom != contentRoom) {
+			loadContent("content.txt", gameContent);
+			contentRoom = currentRoom;
+			// The monsters are recreated with the new stats. The monsters from earlier rooms have already been beaten so this only matters for the rooms ahead.
+			phantom = Monster("Phantom", gameContent.phantomHp, gameContent.phantomAtk);
+			ghoul = Monster("Ghoul", gameContent.ghoulHp, gameContent.ghoulAtk);
+			guardian = Monster("Guardian", gameContent.guardianHp, gameContent.guardianAtk);
+			necromancer = Monster("Necromancer", gameContent.necromancerHp, gameContent.necromancerAtk);
+			// Save the game to a file too so if the game gets closed or crashes the player can continue from this room next time
+			saveGame("savegame.txt", player, currentRoom);
+		}
 		// We use a switch statement to determine what happens in each room based on the current room number
 		switch (currentRoom) {
 
@@ -263,49 +654,40 @@ int main() {
 			// We also give the player the basic options to check their stats, inventory, or exit the game
 			// Because we are giving so many options for a player to choose from in each room we will use nested switch statements to handle the logic for each choice.
 			// Visual border
-			cout << setfill('-') << setw(120) << "" << setfill(' ') << endl;
-			cout << "You enter a large dark and musty chamber. In front of you looms a long and narrow hallway.\nDo you choose to head down the hallway or explore the chamber first?" << endl;
-			cout << "1: Move down the hallway" << endl;
-			cout << "2: Explore the chamber" << endl;
-			cout << "3. Current Stats" << endl;
-			cout << "4. Inventory" << endl;
-			cout << "5. Exit Game" << endl;
+			cout << setfill('-') << setw(120) << "" << setfill(' ') << "\n";
+			cout << "You enter a large dark and musty chamber. In front of you looms a long and narrow hallway.\nDo you choose to head down the hallway or explore the chamber first?\n";
+			cout << "1: Move down the hallway\n";
+			cout << "2: Explore the chamber\n";
+			cout << "3. Current Stats\n";
+			cout << "4. Inventory\n";
+			cout << "5. Exit Game\n";
 
 			// Here we get the player's choice for what they want to do in the first room
 			int roomChoice;
-			cin >> roomChoice;
+			readInput(roomChoice);
+			decisionTrace.record(ROOM_CHOICE, roomChoice);
 
 			// ----------------------------------------------- ROOM 1 CHOICES ------------------------------------------------
 			switch (roomChoice) {
 			case 1:
 				// If the player chooses to head down the hallway then we move to the next room 
 				// No rewards or consequences for choosing this option
-				cout << "You cautiously make your way down the hallway..." << endl;
+				cout << "You cautiously make your way down the hallway...\n";
 				currentRoom++; // Move to the next room
 				break;
 			case 2: {
 				// If the player choose to explore the chamber then we give them a reward but also a consequence for taking something that wasn't theirs
-				cout << "You decide to explore the chamber and find a health potion hidden in a chest!\nBut something in the shadows of the great chamber seems upset that you took something that wasn't yours.\nYou are confronted by a Phantom!" << endl;
+				cout << "You decide to explore the chamber and find a health potion hidden in a chest!\nBut something in the shadows of the great chamber seems upset that you took something that wasn't yours.\nYou are confronted by a Phantom!\n";
 				// We add the health potion to the player's inventory
 				player.addItem(HEALTH_POTION);
 				// Here we would call a function to handle the combat between the player and the goblin
 				CombatResult combatResult = combat(player, phantom);
-				// After the combat we check to return type of the combat result 
-				if (combatResult == PLAYER_WON) {
-					cout << "After your victory you decide to head down the hallway..." << endl;
+				// After the combat we check the combat result. The helper function takes care of the player dying or fleeing and only returns true if the player won
+				if (handleCombatResult(combatResult, phantom, gameOver)) {
+					cout << "After your victory you decide to head down the hallway...\n";
 					// If the player won the combat then we move to the next room
 					currentRoom++;
 				}
-				else if (combatResult == PLAYER_DIED) {
-					// If the player died in combat then we tell the player that they have died and end the game by setting gameOver to true
-					cout << "You have died in combat to the " << phantom.name << " . Game Over." << endl;
-					gameOver = true;
-				}
-				else if (combatResult == PLAYER_EXITED) {
-					// If the player chose to exit combat then we tell the player that they have fled and abandoned their quest and end the game by setting gameOver to true
-					cout << "You have fled from combat and abandoned your quest. Game Over." << endl;
-					gameOver = true;
-				}
 				break;
 			}
 			case 3: 
@@ -320,66 +702,57 @@ int main() {
 				break;
 			case 5:
 				// If the player chooses to exit the game then we set gameOver to true to end the loop and end the game
-				cout << "You have chosen to exit the game." << endl;
+				cout << "You have chosen to exit the game.\n";
 				gameOver = true;
 				break;
 			default:
 				// If the player enters an invalid choice then we display an error message
-				cout << "Invalid choice! Please select a valid option number." << endl;
+				cout << "Invalid choice! Please select a valid option number.\n";
 				break;
 			}
 			break;
 
 		// ------------------------------------------------ ROOM 2 ------------------------------------------------
 		case 2:
-			cout << setfill('-') << setw(120) << "" << setfill(' ') << endl;
-			cout << "After traversing the long, narrow hallway you enter a dimly lit room. As your stumble around the room you find your self face to face with a ghoul!" << endl;
-			cout << "You realize the ghoul seems to be holding something shiny that you might want." << endl;
-			cout << "You could challenge the ghoul and take what it's holding for yourself or you could use the darkness of the room to flee but you might not escape unscathed." << endl;
-			cout << "1: Challenge the ghoul for the shiny object." << endl;
-			cout << "2. Make a run for it!" << endl;
-			cout << "3. Currents Stats" << endl;
-			cout << "4. Inventory" << endl;
-			cout << "5. Exit Game" << endl;
+			cout << setfill('-') << setw(120) << "" << setfill(' ') << "\n";
+			cout << "After traversing the long, narrow hallway you enter a dimly lit room. As your stumble around the room you find your self face to face with a ghoul!\n";
+			cout << "You realize the ghoul seems to be holding something shiny that you might want.\n";
+			cout << "You could challenge the ghoul and take what it's holding for yourself or you could use the darkness of the room to flee but you might not escape unscathed.\n";
+			cout << "1: Challenge the ghoul for the shiny object.\n";
+			cout << "2. Make a run for it!\n";
+			cout << "3. Currents Stats\n";
+			cout << "4. Inventory\n";
+			cout << "5. Exit Game\n";
 			
 			// We get the player's choice for this room 
 			int room2Choice;
-			cin >> room2Choice;
+			readInput(room2Choice);
+			decisionTrace.record(ROOM_CHOICE, room2Choice);
 			// ----------------------------------------------- ROOM 2 CHOICES ------------------------------------------------
 			switch (room2Choice) {
 			case 1: {
-				cout << "You decide to challenge the ghoul for the shiny object. You engage in combat with the ghoul!" << endl;
+				cout << "You decide to challenge the ghoul for the shiny object. You engage in combat with the ghoul!\n";
 				// Here we call the function to handle the combat between the player and the orc
 				CombatResult combatResult = combat(player, ghoul);
-				// After the combat we check to return type of the combat result
-				if (combatResult == PLAYER_WON) {
-					cout << "After your victory you take the shiny object off the ghoul and find that it was a strength elixir! You add it to your inventory and then you head to the next room..." << endl;
+				// After the combat we check the combat result. The helper function takes care of the player dying or fleeing and only returns true if the player won
+				if (handleCombatResult(combatResult, ghoul, gameOver)) {
+					cout << "After your victory you take the shiny object off the ghoul and find that it was a strength elixir! You add it to your inventory and then you head to the next room...\n";
 					// Add the strength elix to the player's inventory 
 					player.addItem(STRENGTH_ELIXIR);
 					// Then we move on to the next room 
 					currentRoom++;
 				}
-				else if (combatResult == PLAYER_DIED) {
-					// If the player died in combat then we tell the player that they have died and end the game by setting gameOver to true
-					cout << "You have died in combat to the " << ghoul.name << " . Game Over." << endl;
-					gameOver = true;
-				}
-				else if (combatResult == PLAYER_EXITED) {
-					// If the player chose to exit combat then we tell the player that they have fled and abandoned their quest and end the game by setting gameOver to true
-					cout << "You have fled from combat and abandoned your quest. Game Over." << endl;
-					gameOver = true;
-				}
 			}
 				  break;
 			case 2: {
-				cout << "You bring your body low to the ground and cloak yourself in the darkness of the room. You attempt to slip past the ghoul but he catches you with a blow to the side." << endl;
+				cout << "You bring your body low to the ground and cloak yourself in the darkness of the room. You attempt to slip past the ghoul but he catches you with a blow to the side.\n";
 				// Here we roll a D20 to check how much dmg the player takes from the orc's attack as they try to flee
 				// We will also use this roll to see if the blow was a critical hit (15 or higher) or if it was a critical fail (5 or lower)
 				int fleeRoll = rollD20();
 				// If the flee roll is 15 or higher then we consider that a critical hit.
 				// The player will take the damage and be caught by the orc and forced into combat.
-				if (fleeRoll >= 15) {
-					cout << "Critical Hit! The ghoul's blow is especially powerful and knocks you to the ground. Now you have no way to escape and have to fight to survive!" << endl;
+				if (fleeRoll >= gameContent.fleeCritRoll) {
+					cout << "Critical Hit! The ghoul's blow is especially powerful and knocks you to the ground. Now you have no way to escape and have to fight to survive!\n";
 					// We calculate the damage the orc deals to the player by rolling a D20 and adding the orc's attack power.
 					int ghoulDmg = rollD20() + ghoul.atkPwr;
 					// Then we subtract that damage from the player's HP. 
@@ -388,53 +761,43 @@ int main() {
 					if (player.hp > 0) {
 						// If the player is still alive then we call the combat function to handle the combat between the player and the orc
 						CombatResult combatResult = combat(player, ghoul);
-						// After the combat we check to return type of the combat result
-						if (combatResult == PLAYER_WON) {
-							cout << "After your victory you take the shiny object off the ghoul and find that it was a strength elixir! You add it to your inventory and then you head to the next room..." << endl;
+						// After the combat we check the combat result. The helper function takes care of the player dying or fleeing and only returns true if the player won
+						if (handleCombatResult(combatResult, ghoul, gameOver)) {
+							cout << "After your victory you take the shiny object off the ghoul and find that it was a strength elixir! You add it to your inventory and then you head to the next room...\n";
 							// Add the strength elix to the player's inventory 
 							player.addItem(STRENGTH_ELIXIR);
 							// Then we move on to the next room 
 							currentRoom++;
 						}
-						else if (combatResult == PLAYER_DIED) {
-							// If the player died in combat then we tell the player that they have died and end the game by setting gameOver to true
-							cout << "You have died in combat to the " << ghoul.name << " . Game Over." << endl;
-							gameOver = true;
-						}
-						else if (combatResult == PLAYER_EXITED) {
-							// If the player chose to exit combat then we tell the player that they have fled and abandoned their quest and end the game by setting gameOver to true
-							cout << "You have fled from combat and abandoned your quest. Game Over." << endl;
-							gameOver = true;
-						}
 					}
 					else {
 						// If the player is not alive after taking damage from trying to flee then we tell them that they have died and end the game by setting gameOver to true
-						cout << "The blow from the ghoul was too much for you and you died as you tried to flee. Game Over." << endl;
+						cout << "The blow from the ghoul was too much for you and you died as you tried to flee. Game Over.\n";
 						gameOver = true;
 					}
-				} else if (fleeRoll <= 5) {
+				} else if (fleeRoll <= gameContent.fleeSlipRoll) {
 						// If the flee roll is 5 or lower then we consider that a critical fail. 
 						// The player takes no damage from the orc and they are able to swipe the shiny object off its waist in the process
-						cout << "Critical Miss! Your dexterity is unmatched and the ghoul's blow slides off your body as if you were darkness iteself." << endl;
-						cout << "The ghoul stumbles after his failed attack and you use this opportunity to swipe the shiny object off his waist! You find that it was a strength elixir and you add it to your inventory." << endl;
+						cout << "Critical Miss! Your dexterity is unmatched and the ghoul's blow slides off your body as if you were darkness iteself.\n";
+						cout << "The ghoul stumbles after his failed attack and you use this opportunity to swipe the shiny object off his waist! You find that it was a strength elixir and you add it to your inventory.\n";
 						player.addItem(STRENGTH_ELIXIR);
-						cout << "You successfully flee to the next room and leave the confused ghoul behind you..." << endl;
+						cout << "You successfully flee to the next room and leave the confused ghoul behind you...\n";
 						currentRoom++;
 				} else {
 					// If the flee roll is between 6 and 14 then we consider that a normal attempt to flee. The player takes damage from the orc's attack but they are able to escape and flee to the next room
-					cout << "You take the hit from the ghoul and lose your footing." << endl;
+					cout << "You take the hit from the ghoul and lose your footing.\n";
 					// We calculate the damage the orc deals to the player by rolling a D20 and adding the orc's attack power.
 					int orcDmg = rollD20() + ghoul.atkPwr;
 					// Then we subtract that damage from the player's HP.
 					applyDamage(player, orcDmg);
 					// After the player takes damage from the orc's attack then we check to see if they are still alive.
 					if (player.hp > 0) {
-						cout << "The damage wasn't enough to bring you down and you successfully flee to the next room and leave the ghoul behind you..." << endl;
+						cout << "The damage wasn't enough to bring you down and you successfully flee to the next room and leave the ghoul behind you...\n";
 						currentRoom++;
 					}
 					else {
 						// If the player is not alive after taking damage from trying to flee then we tell them that they have died and end the game by setting gameOver to true
-						cout << "The blow from the ghoul was too much for you and you died as you tried to flee. Game Over." << endl;
+						cout << "The blow from the ghoul was too much for you and you died as you tried to flee. Game Over.\n";
 						gameOver = true;
 					}
 				}
@@ -452,62 +815,75 @@ int main() {
 				break;
 			case 5: 
 				// If the player chooses to exit the game then we set gameOver to true to end the loop and end the game
-				cout << "You have chosen to exit the game." << endl;
+				cout << "You have chosen to exit the game.\n";
 				gameOver = true;
 				break;
 			default:
 				// If the player enters an invalid choice then we display an error message
-				cout << "Invalid choice! Please select a valid option number." << endl;
+				cout << "Invalid choice! Please select a valid option number.\n";
 				break;
 			}
 			break;
 		
 		// ------------------------------------------------ ROOM 3 ------------------------------------------------
 		case 3:
-			cout << setfill('-') << setw(120) << "" << setfill(' ') << endl;
-			cout << "You find yourself now in a grand hall. The ceiling of the room almost seems to disapear into the darkness. The air in the room itself seems to fill you with a feeling of reverance but you're not sure for what." << endl;
-			cout << "In the center of the room looms an altar that seems to pull you in with its presence." << endl;
-			cout << "You approach the altar and you feel it whispering to you. Urging you to offer up a prayer. What do you decide to do?" << endl;
-			cout << "1. You pray to the altar." << endl;
-			cout << "2. This thing creeps you out so decide to leave the room as fast as you can." << endl;
-			cout << "3. Currents Stats" << endl;
-			cout << "4. Inventory" << endl;
-			cout << "5. Exit Game" << endl;
+			cout << setfill('-') << setw(120) << "" << setfill(' ') << "\n";
+			cout << "You find yourself now in a grand hall. The ceiling of the room almost seems to disapear into the darkness. The air in the room itself seems to fill you with a feeling of reverance but you're not sure for what.\n";
+			cout << "In the center of the room looms an altar that seems to pull you in with its presence.\n";
+			cout << "You approach the altar and you feel it whispering to you. Urging you to offer up a prayer. What do you decide to do?\n";
+			cout << "1. You pray to the altar.\n";
+			cout << "2. This thing creeps you out so decide to leave the room as fast as you can.\n";
+			cout << "3. Currents Stats\n";
+			cout << "4. Inventory\n";
+			cout << "5. Exit Game\n";
 
 			// We get the player's choice for this room 
 			int room3choice;
-			cin >> room3choice;
+			readInput(room3choice);
+			decisionTrace.record(ROOM_CHOICE, room3choice);
 
 			// ----------------------------------------------- ROOM 3 CHOICES ------------------------------------------------
 			switch (room3choice) {
 			case 1: {
-				cout << "You kneel before the altar and whisper a prayer. You can somehow feel the altar's attention fixated on you as you pray." << endl;
+				cout << "You kneel before the altar and whisper a prayer. You can somehow feel the altar's attention fixated on you as you pray.\n";
 				// If the player chooses to pray to the altar then we roll a D20 to see what the result of their prayer is.
 				int prayerRoll = rollD20();
 				// If the prayer roll is 14 or higher then we consider that the player has received a blessing from the altar. The player's HP and attack power are both increased by 20 points.
-				if (prayerRoll >= 14) {
-					cout << "As you pray, the words seem to come from someone-or something-else entirely. They are not your own, yet they fall from your lips with absolute certainty. Almost as if they have been placed there." << endl;
-					cout << "As you conclude your prayer, the very air around you seems to grin. Power floods through your body. You feel...Stronger. Faster. Better. Yet somewhere, deep within you, you sense an absence-you are no longer whole." << endl;
+				if (prayerRoll >= gameContent.boonRoll) {
+					cout << "As you pray, the words seem to come from someone-or something-else entirely. They are not your own, yet they fall from your lips with absolute certainty. Almost as if they have been placed there.\n";
+					cout << "As you conclude your prayer, the very air around you seems to grin. Power floods through your body. You feel...Stronger. Faster. Better. Yet somewhere, deep within you, you sense an absence-you are no longer whole.\n";
 
 					// The player's max hp is reduced by 5 point as the price for their reward
-					player.maxHp -= 5;
+					player.maxHp -= gameContent.boonMaxHpCost;
+					// The content file could make the cost bigger than the player's max HP so we never let it go below 1. Otherwise the player would leave the altar already dead.
+					if (player.maxHp < 1) {
+						player.maxHp = 1;
+					}
 					// The player restores their HP to full 
 					player.hp = player.maxHp;
 					// The player get a boost of 10 points to their attack power
-					player.atkPwr += 10;
+					player.atkPwr += gameContent.boonAtkBonus;
 					// Display the player's new stat total
 					player.displayStats();
 					// The player moves on to the next room 
-					cout << "With this newfound power you feel ready to face whatever lies ahead. You head to the next room..." << endl;
+					cout << "With this newfound power you feel ready to face whatever lies ahead. You head to the next room...\n";
 					currentRoom++;
 				}
-				else if (prayerRoll <= 7) {
-					cout << "You attempt to pray, but the words stumble as they leave your lips. They feel hollow. They feel unworthy." << endl;
-					cout << "When you finish, A sharp pain sears through your skull. The altar has heard your prayer... and found you lacking." << endl;
+				else if (prayerRoll <= gameContent.curseRoll) {
+					cout << "You attempt to pray, but the words stumble as they leave your lips. They feel hollow. They feel unworthy.\n";
+					cout << "When you finish, A sharp pain sears through your skull. The altar has heard your prayer... and found you lacking.\n";
 
 					// The player is cursed by the altar and loses 10 point to their max hp and 5 points to their attack power
-					player.maxHp -= 10;
-					player.atkPwr -= 5;
+					player.maxHp -= gameContent.curseMaxHpLoss;
+					player.atkPwr -= gameContent.curseAtkLoss;
+					// The content file could make the curse bigger than the player's stats so we never let them go below 1.
+					// Otherwise the player could be left with negative HP, or negative attack power that would heal the monster when they attack.
+					if (player.maxHp < 1) {
+						player.maxHp = 1;
+					}
+					if (player.atkPwr < 1) {
+						player.atkPwr = 1;
+					}
 					// Set the player's current HP to the new max HP if their current HP exceeds the new max HP after the curse is applied
 					// Otherwise we can just leave their hp as it is because the curse only reduces the player's max HP 
 					if (player.hp > player.maxHp) {
@@ -516,24 +892,24 @@ int main() {
 					// Display the player's new stat total
 					player.displayStats();
 					// The player moves on to the next room
-					cout << "Feeling shaken and frail from the altar's curse you decide to move on to the next room..." << endl;
+					cout << "Feeling shaken and frail from the altar's curse you decide to move on to the next room...\n";
 					currentRoom++;
 				}
 				else {
 					// If the prayer roll is between 8 and 13 then we consider that the altar is indifferent to the player. The player receives no blessings or curses and their stats remain unchanged.
-					cout << "You offer your prayer, but nothing stirs. The altar remains silent, its presence cold and distant. Whatever listens here does not answer." << endl;
+					cout << "You offer your prayer, but nothing stirs. The altar remains silent, its presence cold and distant. Whatever listens here does not answer.\n";
 					// display the player's current stat total
 					player.displayStats();
 					// The player moves on to the next room
-					cout << "Though you aren't sure what you expected, you decide its best to move on to the next room..." << endl;
+					cout << "Though you aren't sure what you expected, you decide its best to move on to the next room...\n";
 					currentRoom++;
 				}
 			}
 				break;
 			case 2: 
 				// If the player chooses to leave the room then the player gets a hp pot and moves on
-				cout << "You decide not to tempt fate and shut out the altar's whispers. Your head becomes clearer and your thoughts become your own again. You realize that there is a health potion on a pedestal next to the altar." << endl;
-				cout << "You take the health potion and add it to your inventory and then you head to the next room..." << endl;
+				cout << "You decide not to tempt fate and shut out the altar's whispers. Your head becomes clearer and your thoughts become your own again. You realize that there is a health potion on a pedestal next to the altar.\n";
+				cout << "You take the health potion and add it to your inventory and then you head to the next room...\n";
 				// Add the health potion to the player's inventory
 				player.addItem(HEALTH_POTION);
 				// Move to the next room
@@ -551,109 +927,80 @@ int main() {
 				break;
 			case 5: 
 				// If the player chooses to exit the game then we set gameOver to true to end the loop and end the game
-				cout << "You have chosen to exit the game." << endl;
+				cout << "You have chosen to exit the game.\n";
 				gameOver = true;
 				break;
 			default: 
 				// If the player enters an invalid choice then we display an error message
-				cout << "Invalid choice! Please select a valid option number." << endl;
+				cout << "Invalid choice! Please select a valid option number.\n";
 				break;
 			}
 			break;
 		// ------------------------------------------------ ROOM 4 ------------------------------------------------
 		case 4:
-			cout << setfill('-') << setw(120) << "" << setfill(' ') << endl;
-			cout << "You enter a chamber with massive double doors at its far end. A lone guardian stands before them, unmoving." << endl;
-			cout << "As you draw closer, its attention shifts to you. It has not yet acted, but it seems ready. What do you choose to do?" << endl;
-			cout << "1. Draw your weapon and ready yourself." << endl;
-			cout << "2. Attempt to deceive the guardian." << endl;
-			cout << "3. Currents Stats" << endl;
-			cout << "4. Inventory" << endl;
-			cout << "5. Exit Game" << endl;
+			cout << setfill('-') << setw(120) << "" << setfill(' ') << "\n";
+			cout << "You enter a chamber with massive double doors at its far end. A lone guardian stands before them, unmoving.\n";
+			cout << "As you draw closer, its attention shifts to you. It has not yet acted, but it seems ready. What do you choose to do?\n";
+			cout << "1. Draw your weapon and ready yourself.\n";
+			cout << "2. Attempt to deceive the guardian.\n";
+			cout << "3. Currents Stats\n";
+			cout << "4. Inventory\n";
+			cout << "5. Exit Game\n";
 
 			// We get the player's choice for this room
 			int room4choice;
-			cin >> room4choice;
+			readInput(room4choice);
+			decisionTrace.record(ROOM_CHOICE, room4choice);
 			// ----------------------------------------------- ROOM 4 CHOICES ------------------------------------------------
 			switch (room4choice) {
 			case 1: {
-				cout << "You draw your weapon and the guardian does the same. You prepare for combat." << endl;
+				cout << "You draw your weapon and the guardian does the same. You prepare for combat.\n";
 				// We start combat with the guardian 
 				CombatResult combatResult = combat(player, guardian);
-				// After the combat we check to return type of the combat result
-				if (combatResult == PLAYER_WON) {
-					cout << "You find yourself victorious. Now what was this guardian protecting behind these doors?" << endl;
+				// After the combat we check the combat result. The helper function takes care of the player dying or fleeing and only returns true if the player won
+				if (handleCombatResult(combatResult, guardian, gameOver)) {
+					cout << "You find yourself victorious. Now what was this guardian protecting behind these doors?\n";
 					// Then we move on to the next room 
 					currentRoom++;
-					}
-				else if (combatResult == PLAYER_DIED) {
-					// If the player died in combat then we tell the player that they have died and end the game by setting gameOver to true
-					cout << "You have died in combat to the " << guardian.name << " . Game Over." << endl;
-					gameOver = true;
-					}
-				else if (combatResult == PLAYER_EXITED) {
-					// If the player chose to exit combat then we tell the player that they have fled and abandoned their quest and end the game by setting gameOver to true
-					cout << "You have fled from combat and abandoned your quest. Game Over." << endl;
-					gameOver = true;
-					}
+				}
 				}
 				  break;
 			case 2: {
-				cout << "With confidence you announce that higher authorities have sent you to relieve the guardian of its duty. You explain that you are here to take over... guardianing?" << endl;
+				cout << "With confidence you announce that higher authorities have sent you to relieve the guardian of its duty. You explain that you are here to take over... guardianing?\n";
 				// Now we roll a D20 to see if the player's charism is enough to deceive the guardian.
 				int deceiveRoll = rollD20();
 				// If the deceive roll is 12 or higher then we consider that the player successfully deceived the guardian and they are able to pass through the doors without combat.
-				if (deceiveRoll >= 12) {
-					cout << "The guardian seems to consider your words for a moment. Then, without a word, it steps aside. It seems your bluff has worked and you are able to pass through the doors without combat." << endl;
+				if (deceiveRoll >= gameContent.deceivePassRoll) {
+					cout << "The guardian seems to consider your words for a moment. Then, without a word, it steps aside. It seems your bluff has worked and you are able to pass through the doors without combat.\n";
 					// Move to the next room
 					currentRoom++;
 				}
-				else if (deceiveRoll <= 5) {
+				else if (deceiveRoll <= gameContent.deceiveEnrageRoll) {
 					// If the deceive roll is 5 or lower then we consider that the player failed to deceive the guardian and they are forced into combat.
-					cout << "The guardian's eyes narrow as it considers your words. It seems to see through your deception and seems enraged that you would even try to. It bolsters itself and prepares to attack!" << endl;
+					cout << "The guardian's eyes narrow as it considers your words. It seems to see through your deception and seems enraged that you would even try to. It bolsters itself and prepares to attack!\n";
 					// Since the player has critically failed the deception check, the guardian becomes enraged and gets a boost to its atkPwr and HP for the combat encounter
-					guardian.atkPwr += 5;
-					guardian.hp += 10;
+					guardian.atkPwr += gameContent.enragedAtkBonus;
+					guardian.hp += gameContent.enragedHpBonus;
 					// We start combat with the guardian 
 					CombatResult combatResult = combat(player, guardian);
-					// After the combat we check to return type of the combat result
-					if (combatResult == PLAYER_WON) {
-						cout << "You find yourself victorious. Now what was this guardian protecting behind these doors?" << endl;
+					// After the combat we check the combat result. The helper function takes care of the player dying or fleeing and only returns true if the player won
+					if (handleCombatResult(combatResult, guardian, gameOver)) {
+						cout << "You find yourself victorious. Now what was this guardian protecting behind these doors?\n";
 						// Then we move on to the next room 
 						currentRoom++;
 					}
-					else if (combatResult == PLAYER_DIED) {
-						// If the player died in combat then we tell the player that they have died and end the game by setting gameOver to true
-						cout << "You have died in combat to the " << guardian.name << " . Game Over." << endl;
-						gameOver = true;
-					}
-					else if (combatResult == PLAYER_EXITED) {
-						// If the player chose to exit combat then we tell the player that they have fled and abandoned their quest and end the game by setting gameOver to true
-						cout << "You have fled from combat and abandoned your quest. Game Over." << endl;
-						gameOver = true;
-					}
 				}
 				else {
 					// If the roll is between 6 and 11 then the player failed to deceive the guardian and are met with a normal combat encounter. The guardian does not get enraged and does not receive any stat boosts for the combat encounter.
-					cout << "The guardian's eyes narrow as it considers your words. There seems to be no other response except for it raising it's weapon. It's time to fight." << endl;
+					cout << "The guardian's eyes narrow as it considers your words. There seems to be no other response except for it raising it's weapon. It's time to fight.\n";
 					// We start combat with the guardian
 					CombatResult combatResult = combat(player, guardian);
-					// After the combat we check to return type of the combat result
-					if (combatResult == PLAYER_WON) {
-						cout << "You find yourself victorious. Now what was this guardian protecting behind these doors?" << endl;
+					// After the combat we check the combat result. The helper function takes care of the player dying or fleeing and only returns true if the player won
+					if (handleCombatResult(combatResult, guardian, gameOver)) {
+						cout << "You find yourself victorious. Now what was this guardian protecting behind these doors?\n";
 						// Then we move on to the next room
 						currentRoom++;
 					}
-					else if (combatResult == PLAYER_DIED) {
-						// If the player died in combat then we tell the player that they have died and end the game by setting gameOver to true
-						cout << "You have died in combat to the " << guardian.name << " . Game Over." << endl;
-						gameOver = true;
-					}
-					else if (combatResult == PLAYER_EXITED) {
-						// If the player chose to exit combat then we tell the player that they have fled and abandoned their quest and end the game by setting gameOver to true
-						cout << "You have fled from combat and abandoned your quest. Game Over." << endl;
-						gameOver = true;
-					}
 				}
 			}
 				break;
@@ -669,55 +1016,46 @@ int main() {
 				break;
 			case 5:
 				// If the player chooses to exit the game then we set gameOver to true to end the loop and end the game
-				cout << "You have chosen to exit the game." << endl;
+				cout << "You have chosen to exit the game.\n";
 				gameOver = true;
 				break;
 			default:
 				// If the player enters an invalid choice then we display an error message
-				cout << "Invalid choice! Please select a valid option number." << endl;
+				cout << "Invalid choice! Please select a valid option number.\n";
 				break;
 			}
 			break;
 		// ------------------------------------------------ ROOM 5 ------------------------------------------------
 		case 5:
-			cout << setfill('-') << setw(120) << "" << setfill(' ') << endl;
-			cout << "You step into the final chamber. The chamber is is filled with a thin, unnatural fog.\nAs you push through it, a figure emerges. A necromancer." << endl;
-			cout << "Every part of your recoils at its presence. This creature is pure evil. It cannot be allowed to live." << endl;
-			cout << "1. You prepare yourself and think 'Time to save the world I guess?'" << endl;
-			cout << "2. You decide that this is too much for you and you make a run for it." << endl;
-			cout << "3. Currents Stats" << endl;
-			cout << "4. Inventory" << endl;
-			cout << "5. Exit Game" << endl;
+			cout << setfill('-') << setw(120) << "" << setfill(' ') << "\n";
+			cout << "You step into the final chamber. The chamber is is filled with a thin, unnatural fog.\nAs you push through it, a figure emerges. A necromancer.\n";
+			cout << "Every part of your recoils at its presence. This creature is pure evil. It cannot be allowed to live.\n";
+			cout << "1. You prepare yourself and think 'Time to save the world I guess?'\n";
+			cout << "2. You decide that this is too much for you and you make a run for it.\n";
+			cout << "3. Currents Stats\n";
+			cout << "4. Inventory\n";
+			cout << "5. Exit Game\n";
 
 			// We get the player's choice for this room
 			int room5choice;
-			cin >> room5choice;
+			readInput(room5choice);
+			decisionTrace.record(ROOM_CHOICE, room5choice);
 			// ----------------------------------------------- ROOM 5 CHOICES ------------------------------------------------
 			switch (room5choice) {
 			case 1: {
-				cout << "You steel your nerves and prepare to fight the necromancer. This is it. The final battle." << endl;
+				cout << "You steel your nerves and prepare to fight the necromancer. This is it. The final battle.\n";
 				// We start combat with the necromancer
 				CombatResult combatResult = combat(player, necromancer);
-				// After the combat we check to return type of the combat result
-				if (combatResult == PLAYER_WON) {
-					cout << "Against all odds, you have defeated the necromancer and saved the world! Congratulations on beating the game!" << endl;
+				// After the combat we check the combat result. The helper function takes care of the player dying or fleeing and only returns true if the player won
+				if (handleCombatResult(combatResult, necromancer, gameOver)) {
+					cout << "Against all odds, you have defeated the necromancer and saved the world! Congratulations on beating the game!\n";
 					// Then we end the game by setting gameOver to true
 					gameOver = true;
 				}
-				else if (combatResult == PLAYER_DIED) {
-					// If the player died in combat then we tell the player that they have died and end the game by setting gameOver to true
-					cout << "You have died in combat to the " << necromancer.name << " . Game Over." << endl;
-					gameOver = true;
-				}
-				else if (combatResult == PLAYER_EXITED) {
-					// If the player chose to exit combat then we tell the player that they have fled and abandoned their quest and end the game by setting gameOver to true
-					cout << "You have fled from combat and abandoned your quest. Game Over." << endl;
-					gameOver = true;
-				}
 			}
 				break;
 			case 2:
-				cout << "You just wanted a simple adventure, not whatever this is. You're just a coward after all. You turn around and abandon your quest." << endl;
+				cout << "You just wanted a simple adventure, not whatever this is. You're just a coward after all. You turn around and abandon your quest.\n";
 				// We end the game by setting gameOver to true
 				gameOver = true;
 				break;
@@ -733,32 +1071,271 @@ int main() {
 				break;
 			case 5:
 				// If the player chooses to exit the game then we set gameOver to true to end the loop and end the game
-				cout << "You have chosen to exit the game." << endl;
+				cout << "You have chosen to exit the game.\n";
 				gameOver = true;
 				break;
 			default:
 				// If the player enters an invalid choice then we display an error message
-				cout << "Invalid choice! Please select a valid option number." << endl;
+				cout << "Invalid choice! Please select a valid option number.\n";
 				break;
 			}
 			break;
 		// ------------------------------------------------ DEFAULT ------------------------------------------------
 		default: {
 			// If the current room number does not match any of the cases then we end the game 
-			cout << "You have exited the dungeon<" << endl;
+			cout << "You have exited the dungeon<\n";
 			gameOver = true; // End the game if there is an invalid room number
 			break;
 			}
 		}
 	}
 
-	cout << "Thanks for playing " << player.name << "!" << endl;
+	// The game finished so we delete the save file. Next time the game starts it will be a new game.
+	deleteSave("savegame.txt");
+
+	// Save the decisions and timings from this game if recording is turned on
+	decisionTrace.writeToFile("decision_trace.txt");
+	timingTrace.writeToFile("timing_trace.json");
+
+	cout << "Thanks for playing " << player.name << "!\n";
 	return 0;
 }
 
+// This function will load the game content from a file.
+// It takes 2 parameters
+// 1. The name of the file to load
+// 2. A reference to the content the game is currently using
+// Each line of the file is a name and a number, for example "ghoulHp 80". Any value that isn't in the file keeps its current value.
+// The file is read into a copy first and the copy only replaces the current content if the whole file was read without problems and every value makes sense. That way a half written or broken file never leaves the game with a mix of old and new values.
+// It returns true if new content was loaded.
+bool loadContent(const char* fileName, GameContent& content) {
+	ifstream file(fileName);
+	// If there is no content file then we just keep using the content we already have
+	if (!file) {
+		return false;
+	}
+
+	GameContent newContent = content;
+	string key;
+	int value;
+	while (file >> key) {
+		// Every name has to be followed by a number. If it isn't (for example the file was only half written) then we keep the current content.
+		if (!(file >> value)) {
+			cout << "Missing or bad number for '" << key << "' in " << fileName << ". Keeping the current content.\n";
+			return false;
+		}
+		if (key == "phantomHp") newContent.phantomHp = value;
+		else if (key == "phantomAtk") newContent.phantomAtk = value;
+		else if (key == "ghoulHp") newContent.ghoulHp = value;
+		else if (key == "ghoulAtk") newContent.ghoulAtk = value;
+		else if (key == "guardianHp") newContent.guardianHp = value;
+		else if (key == "guardianAtk") newContent.guardianAtk = value;
+		else if (key == "necromancerHp") newContent.necromancerHp = value;
+		else if (key == "necromancerAtk") newContent.necromancerAtk = value;
+		else if (key == "potionHeal") newContent.potionHeal = value;
+		else if (key == "elixirBoost") newContent.elixirBoost = value;
+		else if (key == "fleeCritRoll") newContent.fleeCritRoll = value;
+		else if (key == "fleeSlipRoll") newContent.fleeSlipRoll = value;
+		else if (key == "boonRoll") newContent.boonRoll = value;
+		else if (key == "boonMaxHpCost") newContent.boonMaxHpCost = value;
+		else if (key == "boonAtkBonus") newContent.boonAtkBonus = value;
+		else if (key == "curseRoll") newContent.curseRoll = value;
+		else if (key == "curseMaxHpLoss") newContent.curseMaxHpLoss = value;
+		else if (key == "curseAtkLoss") newContent.curseAtkLoss = value;
+		else if (key == "deceivePassRoll") newContent.deceivePassRoll = value;
+		else if (key == "deceiveEnrageRoll") newContent.deceiveEnrageRoll = value;
+		else if (key == "enragedAtkBonus") newContent.enragedAtkBonus = value;
+		else if (key == "enragedHpBonus") newContent.enragedHpBonus = value;
+		else {
+			cout << "Unknown content value '" << key << "' in " << fileName << ". Keeping the current content.\n";
+			return false;
+		}
+	}
+
+	// If we stopped before the end of the file then a line couldn't be read so we keep the current content
+	if (!file.eof()) {
+		cout << "Could not read " << fileName << ". Keeping the current content.\n";
+		return false;
+	}
+
+	// Make sure the new values won't break the game before we use them
+	if (!isValidContent(newContent)) {
+		cout << "Some values in " << fileName << " are out of range. Keeping the current content.\n";
+		return false;
+	}
+
+	content = newContent;
+	return true;
+}
+
+// This function turns the seed typed on the command line into a number.
+// It takes 2 parameters
+// 1. The text that was typed for the seed
+// 2. A reference to the seed that will be set if the text is a valid number
+// It returns true only if the whole text is a number from 0 to UINT_MAX.
+bool parseSeed(const char* text, unsigned int& seed) {
+	// strtoul would accept a minus sign and wrap the number around to a huge seed so we only allow digits
+	if (text[0] < '0' || text[0] > '9') {
+		return false;
+	}
+	char* end = nullptr;
+	errno = 0;
+	unsigned long value = strtoul(text, &end, 10);
+	// end points at the first character that wasn't part of the number so it has to be the end of the text. errno is set if the number was too big.
+	if (*end != '\0' || errno == ERANGE || value > UINT_MAX) {
+		return false;
+	}
+	seed = static_cast<unsigned int>(value);
+	return true;
+}
+
+// This function shows how to start the game from the command line.
+// It takes 1 parameter which is the name the game was started with.
+void printUsage(const char* programName) {
+	cout << "Usage: " << programName << " [seed] [--record-decisions] [--trace-timings] [--rewind]\n";
+	cout << "  seed                A whole number that sets the dice so a game can be replayed\n";
+	cout << "  --record-decisions  Add every choice and roll to decision_trace.txt\n";
+	cout << "  --trace-timings     Save the timing of each part of the game to timing_trace.json\n";
+	cout << "  --rewind            Allow rewinding the last combat turn when you die\n";
+}
+
+// This function checks that the game content makes sense.
+// Monsters need more than 0 HP or their fight would end before it starts, every roll threshold has to be a number the d20 can actually roll (1 to 20) and none of the other amounts can be negative.
+// In each room the low roll has to be lower than the high roll. If they overlapped then the high roll would be checked first and quietly take over some of the low roll's chances.
+// It returns true if every value is in range.
+bool isValidContent(const GameContent& content) {
+	// Monster HP
+	if (content.phantomHp <= 0 || content.ghoulHp <= 0 || content.guardianHp <= 0 || content.necromancerHp <= 0) {
+		return false;
+	}
+	// Roll thresholds
+	int rolls[] = { content.fleeCritRoll, content.fleeSlipRoll, content.boonRoll, content.curseRoll, content.deceivePassRoll, content.deceiveEnrageRoll };
+	for (int i = 0; i < 6; i++) {
+		if (rolls[i] < 1 || rolls[i] > 20) {
+			return false;
+		}
+	}
+	if (content.fleeSlipRoll >= content.fleeCritRoll || content.curseRoll >= content.boonRoll || content.deceiveEnrageRoll >= content.deceivePassRoll) {
+		return false;
+	}
+	// Everything else is an attack power, an item amount or a stat change so it just can't be negative
+	// The altar can still take away more max HP or attack power than the player has, so room 3 keeps those stats at 1 or more
+	int amounts[] = { content.phantomAtk, content.ghoulAtk, content.guardianAtk, content.necromancerAtk, content.potionHeal, content.elixirBoost,
+		content.boonMaxHpCost, content.boonAtkBonus, content.curseMaxHpLoss, content.curseAtkLoss, content.enragedAtkBonus, content.enragedHpBonus };
+	for (int i = 0; i < 12; i++) {
+		if (amounts[i] < 0) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// This function will save the game to a file.
+// It takes 3 parameters
+// 1. The name of the save file
+// 2. A reference to the player so we can save their name, stats, block and inventory
+// 3. The room the player is in
+// The dice engine is saved too so a continued game keeps rolling the same dice it would have if it was never closed.
+// We write everything to a temporary file first and only replace the real save file once the temporary file is completely written.
+// On Windows rename won't replace a file that already exists so the old save has to be removed first. If the game is closed right between the remove and the rename then only the temporary file is left, so loadGame falls back to it.
+void saveGame(const char* fileName, const Player& player, int currentRoom) {
+	string tempFileName = string(fileName) + ".tmp";
+	{
+		ofstream file(tempFileName);
+		if (!file) {
+			cout << "Could not save the game.\n";
+			return;
+		}
+		file << player.name << " " << player.hp << " " << player.maxHp << " " << player.atkPwr << " " << player.block << " " << currentRoom << "\n";
+		file << player.inventorySize;
+		for (int i = 0; i < player.inventorySize; i++) {
+			file << " " << player.inventory[i];
+		}
+		file << "\n" << diceEngine << "\n";
+		// Close the file so everything is written, then make sure nothing went wrong while writing
+		file.close();
+		if (!file) {
+			cout << "Could not save the game.\n";
+			// The old save file is still there because we never touched it
+			remove(tempFileName.c_str());
+			return;
+		}
+	}
+	remove(fileName);
+	if (rename(tempFileName.c_str(), fileName) != 0) {
+		// The save is still complete in the temporary file and loadGame will find it there
+		cout << "Could not finish saving the game.\n";
+	}
+}
+
+// This function will load a saved game from a file.
+// It takes 3 parameters
+// 1. The name of the save file
+// 2. A reference to the player that the saved stats and inventory will be loaded into
+// 3. A reference to the current room that will be set to the room the player saved in
+// Everything is read into a copy first. The player and room are only changed if the whole file was read and makes sense.
+// It returns true if a saved game was loaded.
+bool loadGame(const char* fileName, Player& player, int& currentRoom) {
+	ifstream file(fileName);
+	// If the save file is missing then the game might have been closed in the middle of saving, after the old save was removed but before the new one was renamed.
+	// The temporary file is always completely written before the old save is removed so we can load that one instead.
+	if (!file) {
+		file.clear();
+		file.open(string(fileName) + ".tmp");
+	}
+	// No save file at all means there is no game to continue
+	if (!file) {
+		return false;
+	}
+
+	Player savedPlayer = player;
+	int savedRoom = 0;
+	file >> savedPlayer.name >> savedPlayer.hp >> savedPlayer.maxHp >> savedPlayer.atkPwr >> savedPlayer.block >> savedRoom;
+	file >> savedPlayer.inventorySize;
+	// Make sure the stats are ones a living player can have, the same way isValidContent checks the game content.
+	// A player saved with 0 or less HP would go straight into a fight that ends before it starts, so a save like that is treated as broken.
+	if (!file || savedPlayer.hp <= 0 || savedPlayer.maxHp <= 0 || savedPlayer.hp > savedPlayer.maxHp || savedPlayer.atkPwr < 1 || savedPlayer.block < 0) {
+		return false;
+	}
+	// Make sure the room and inventory size are ones the game actually has before using them
+	if (savedRoom < 1 || savedRoom > 5 || savedPlayer.inventorySize < 0 || savedPlayer.inventorySize > 3) {
+		return false;
+	}
+	for (int i = 0; i < savedPlayer.inventorySize; i++) {
+		int item;
+		file >> item;
+		if (item != HEALTH_POTION && item != STRENGTH_ELIXIR) {
+			return false;
+		}
+		savedPlayer.inventory[i] = static_cast<Item>(item);
+	}
+	std::mt19937 savedDice;
+	file >> savedDice;
+	if (!file) {
+		return false;
+	}
+
+	player = savedPlayer;
+	currentRoom = savedRoom;
+	diceEngine = savedDice;
+	return true;
+}
+
+// This function deletes the save file and any temporary file left over from saving.
+// It takes 1 parameter which is the name of the save file.
+void deleteSave(const char* fileName) {
+	remove(fileName);
+	remove((string(fileName) + ".tmp").c_str());
+}
+
 // This function will roll a 20 sided die and return the result as an integer. 
 int rollD20() {
-	return rand() % 20 + 1; 
+	// The distribution turns the engine's random numbers into a number from 1 to 20 where each number is equally likely
+	std::uniform_int_distribution<int> d20(1, 20);
+	int roll = d20(diceEngine);
+	// Record the roll in the decision trace so we can see what happened after each choice
+	decisionTrace.record(DICE_ROLL, roll);
+	return roll;
 }
 
 // This function will apply damage to the player. It will calculate the damage taken while taking in to consideration the player's block stat
@@ -766,6 +1343,7 @@ int rollD20() {
 // 1. A reference to the player object
 // 2. An integer for the amount of damage being dealt to the player before block is applied
 void applyDamage(Player& player, int damage) {
+	TimedSection timer("applyDamage");
 	// First we check to see if the player has any block at all
 	if (player.block > 0) {
 		// If they do then we check to see if either the player's block or the damage being dealt is greater 
@@ -782,8 +1360,8 @@ void applyDamage(Player& player, int damage) {
 		damage -= absorbedDamage;
 
 		// Tell the player how much damage their block absorbed and how much block they have left
-		cout << "Your block absorbed " << absorbedDamage << " damage!" << endl;
-		cout << "Your remaining block is: " << player.block << endl;
+		cout << "Your block absorbed " << absorbedDamage << " damage!\n";
+		cout << "Your remaining block is: " << player.block << "\n";
 	}
 
 	// After we have checked to see if the player has any block then we check to see if there is any damage left to apply to the player's HP after block has been applied
@@ -794,36 +1372,91 @@ void applyDamage(Player& player, int damage) {
 		if (player.hp < 0) {
 			player.hp = 0; // Ensure that the player's HP does not go below 0
 		}
-		cout << "You take " << damage << " damage! Your remaining HP is: " << player.hp << endl;
+		cout << "You take " << damage << " damage! Your remaining HP is: " << player.hp << "\n";
 	}
 }
 
+// This function will handle the result of a combat encounter.
+// Every room was repeating the same checks for the player dying or fleeing after combat so I moved them into this function.
+// It takes 3 parameters
+// 1. The result returned from the combat function
+// 2. A reference to the monster the player was fighting so we can display its name
+// 3. A reference to the gameOver variable from main so we can end the game if the player died or fled
+// It returns true if the player won so that each room can still give its own reward and move the player to the next room.
+bool handleCombatResult(CombatResult combatResult, const Monster& monster, bool& gameOver) {
+	if (combatResult == PLAYER_DIED) {
+		// If the player died in combat then we tell the player that they have died and end the game by setting gameOver to true
+		cout << "You have died in combat to the " << monster.name << " . Game Over.\n";
+		gameOver = true;
+	}
+	else if (combatResult == PLAYER_EXITED) {
+		// If the player chose to exit combat then we tell the player that they have fled and abandoned their quest and end the game by setting gameOver to true
+		cout << "You have fled from combat and abandoned your quest. Game Over.\n";
+		gameOver = true;
+	}
+	return combatResult == PLAYER_WON;
+}
+
+// This function takes a snapshot of the game in the middle of a combat.
+// It takes 3 parameters
+// 1. A reference to the snapshot that will be written over with the game as it is right now
+// 2. A reference to the player object
+// 3. A reference to the monster the player is fighting
+void takeSnapshot(GameSnapshot& snapshot, const Player& player, const Monster& monster) {
+	snapshot.player = player;
+	snapshot.monster = monster;
+	snapshot.dice = diceEngine;
+}
+
+// This function puts the game back the way it was when a snapshot was taken.
+// It takes 3 parameters
+// 1. The snapshot to go back to
+// 2. A reference to the player object that will be set back to the player in the snapshot
+// 3. A reference to the monster object that will be set back to the monster in the snapshot
+// The dice are put back too so the same rolls come up again.
+void restoreSnapshot(const GameSnapshot& snapshot, Player& player, Monster& monster) {
+	player = snapshot.player;
+	monster = snapshot.monster;
+	diceEngine = snapshot.dice;
+}
+
 // This function will handle the combat between the player and a monster.
 // It takes 2 parameters
 // 1. A reference to the player object
 // 2. A reference to the monster object for the monster that the player is fighting
 // Since we are passing the player and monster by reference any changes made to their stats in this function will change the original objects that were passed in.
 CombatResult combat(Player& player, Monster& monster) {
+	TimedSection timer("combat");
 	// Create a variable to track the result of the combat and initialize it to PLAYER_EXITED. This is because if the player chooses to exit combat then we will return this result and end the combat loop.
 	CombatResult result = PLAYER_EXITED;
 	// We also create a boolean variable to track if the combat is over or not and initialize it to false. This is because the combat loop will continue until the combat is over.
 	bool combatOver = false;
 
+	// The snapshot of the start of the current turn, used for rewinding. It is static so it is only created once for the whole game instead of every combat, and it is only filled in when rewinding is turned on.
+	static GameSnapshot turnStart;
+
 	// First we display the name and stats of the monster that the player is fighting
-	cout << "You are fighting a " << monster.name << "!" << endl;
+	cout << "You are fighting a " << monster.name << "!\n";
 
 	// We start the combat loop and it continues as long as both the player and the monster are alive
 	while (!combatOver && player.hp > 0 && monster.hp > 0) {
+		// If rewinding is turned on then we take a snapshot at the start of the turn so the player can rewind to it
+		if (rewindEnabled) {
+			takeSnapshot(turnStart, player, monster);
+		}
+
 		// We display the player and monster's current stats at the start of each turn
-		cout << "Player HP: " << player.hp << " | Monster HP: " << monster.hp << endl;
+		cout << "Player HP: " << player.hp << " | Monster HP: " << monster.hp << "\n";
 		// We give the player a choice of actions to take during their turn
-		cout << "Choose your action:" << endl;
-		cout << "1: Attack\n2: Block\n3: Use Item\n4: Exit Combat" << endl;
+		cout << "Choose your action:\n";
+		cout << "1: Attack\n2: Block\n3: Use Item\n4: Exit Combat\n";
 
 		// Then we get the player's choice for what action they want to take during their turn
 		int actionChoice;
-		cin >> actionChoice;
-
+		readInput(actionChoice);
+		decisionTrace.record(COMBAT_ACTION, actionChoice);
+		// Time the rest of this turn. The timer stops at the end of the loop body, even when we use continue.
+		TimedSection turnTimer("combat turn", false, true);
 
 		switch (actionChoice) {
 		case ATTACK: {
@@ -833,7 +1466,7 @@ CombatResult combat(Player& player, Monster& monster) {
 			// We subtract the damage dealt from the monster's HP
 			monster.hp -= playerDmg;
 			// Then we print out the damage dealt to the monster
-			cout << "You attack the " << monster.name << " and deal " << playerDmg << " damage!" << endl;
+			cout << "You attack the " << monster.name << " and deal " << playerDmg << " damage!\n";
 			break;
 		}
 
@@ -844,9 +1477,9 @@ CombatResult combat(Player& player, Monster& monster) {
 			// We add the block amount to the player's block stat
 			player.block += blockAmount;
 			// We also print out the amount that the player has blocked for this turn
-			cout << "You block and increase your block stat by " << blockAmount << " for this turn!" << endl;
+			cout << "You block and increase your block stat by " << blockAmount << " for this turn!\n";
 			// Then we print what the player's new block stat total is
-			cout << "Your current block stat is: " << player.block << endl;
+			cout << "Your current block stat is: " << player.block << "\n";
 			break;
 		}
 
@@ -858,14 +1491,14 @@ CombatResult combat(Player& player, Monster& monster) {
 
 		case EXIT: {
 			// If the player chooses to exit combat then we set combatOver to true to end the combat loop and we return the result of PLAYER_EXITED
-			cout << "You have chosen to exit combat." << endl;
+			cout << "You have chosen to exit combat.\n";
 			combatOver = true;
 			result = PLAYER_EXITED;
 			break;
 		}
 
 		default:
-			cout << "Invalid choice! Please select a valid action number." << endl;
+			cout << "Invalid choice! Please select a valid action number.\n";
 			break;
 		}
 
@@ -881,11 +1514,22 @@ CombatResult combat(Player& player, Monster& monster) {
 		// We calculate the damage the monster deals to the player by rolling a D20 and adding the monster's attack power
 		int monsterDmg = rollD20() + monster.atkPwr;
 		// Then we print out the damage that the monster is trying to deal to the player
-		cout << "The " << monster.name << " attacks you for " << monsterDmg << " damage!" << endl;
+		cout << "The " << monster.name << " attacks you for " << monsterDmg << " damage!\n";
 		// Then we call the applyDamage function to apply the damage to the player
 		applyDamage(player, monsterDmg);
 
 		// After the monster's attack we check to see if the player died
+		// If rewinding is turned on then we give the player the option to go back to the start of this turn and choose a different action
+		if (player.hp <= 0 && rewindEnabled) {
+			cout << "Would you like to rewind to the start of this turn and choose a different action? (yes/no) ";
+			string rewindChoice;
+			readInput(rewindChoice);
+			if (rewindChoice == "yes") {
+				restoreSnapshot(turnStart, player, monster);
+				cout << "Time seems to fold back on itself and you find yourself at the start of the turn again...\n";
+				continue;
+			}
+		}
 		if (player.hp <= 0) {
 			// If the player's HP is 0 or less then we set combatOver to true to end the combat loop and we return the result of PLAYER_DIED
 			combatOver = true;